@@ -43,6 +43,7 @@
 #include <iomanip>
 #include <sys/stat.h>
 #include <chrono>  // For high resolution clock
+#include <algorithm>
 
 // This is an implementation of the TGax (HEW) outdoor scenario.
 using namespace std;
@@ -50,6 +51,40 @@ using namespace ns3;
 
 NS_LOG_COMPONENT_DEFINE ("hew-outdoor");
 
+/*******  Per-device airtime and channel-state counters *******/
+
+struct DeviceStats
+{
+    double idleTime = 0.0;		// Time in PHY IDLE state [s]
+    double ccaBusyTime = 0.0;		// Time in PHY CCA_BUSY state [s]
+    double txTime = 0.0;		// Time in PHY TX state [s]
+    double rxTime = 0.0;		// Time in PHY RX state [s]
+    uint64_t rxOk = 0;			// PSDUs addressed to this device received successfully
+    uint64_t rxError = 0;		// PSDUs addressed to this device received with errors
+    uint64_t rxOkOther = 0;		// Other PSDUs (group addressed, overheard in own BSS or OBSS) received successfully
+    uint64_t rxErrorOther = 0;		// Other PSDUs received with errors
+    uint64_t rxDropBusy = 0;		// PPDUs dropped because the PHY was already receiving or transmitting
+    uint64_t rxDropOther = 0;		// PPDUs dropped for other reasons (e.g. preamble detection failure)
+    uint64_t retransmissions = 0;	// Transmitted data MPDUs with the Retry bit set
+    uint64_t dataPpdus = 0;		// Transmitted PPDUs carrying QoS data
+    uint64_t dataMpdus = 0;		// MPDUs carried in those PPDUs
+    uint32_t maxAmpdu = 0;		// Largest A-MPDU transmitted [MPDUs]
+    double payloadTime = 0.0;		// Airtime of the MSDU bytes sent for the first time in those PPDUs at the data rate [s]
+    Mac48Address address;		// MAC address of the device
+    Time start;				// Counters only cover the time after the warm-up
+    Time lastStateEnd;			// End of the last PHY state period logged
+};
+
+/*******  Aggregation and TXOP profiles (best effort AC) *******/
+
+struct AggProfile
+{
+    uint32_t maxAmpduSize;	// BE_MaxAmpduSize [bytes], 0 disables A-MPDU
+    uint16_t maxAmsduSize;	// BE_MaxAmsduSize [bytes], 0 disables A-MSDU
+    uint16_t mpduBufferSize;	// Block Ack window [MPDUs], only configurable for HE
+    Time txopLimit;		// BE TXOP limit, 0 allows a single PPDU per channel access
+};
+
 /*******  Forward declaration of functions *******/
 
 int countAPs(int layers); // Count the number of APs per layer
@@ -59,6 +94,11 @@ double **calculateSTApositions(double x_ap, double y_ap, int h, int n_stations);
 void installTrafficGenerator(Ptr<ns3::Node> fromNode, Ptr<ns3::Node> toNode, int port, std::string offeredLoad, int packetSize, int simulationTime, int warmupTime);
 void showPosition(NodeContainer &Nodes); // Show AP's positions (only in debug mode)
 void PopulateARPcache ();
+int hexRing(int APindex); // Hex grid ring (layer) of a given AP, 0 is the central AP
+void connectDeviceStats(Ptr<NetDevice> device, DeviceStats *stats, Time start); // Hook device counters to WifiPhy/MAC trace sources
+void flushDeviceStats(Ptr<NetDevice> device, DeviceStats *stats, Time end); // Account for the PHY state still pending at the end
+AggProfile getAggProfile(std::string name, std::string phy); // Aggregation, Block Ack and TXOP settings of a named profile
+void setTxopLimit(Ptr<NetDevice> device, Time txopLimit); // Set BE TXOP limit of an installed device
 
 bool fileExists(const std::string& filename)
 {
@@ -91,6 +131,9 @@ int main (int argc, char *argv[])
     int warmupTime = 1;
     int packetSize = 1472;
     std::string outputCsv = "ex7-outdoor.csv";
+    std::string outputRunCsv = "ex7-outdoor-runs.csv"; // Per-run aggregation profile and MAC efficiency
+    std::string outputDevCsv = "ex7-outdoor-devices.csv"; // Per-device airtime counters
+    std::string aggProfileName = "default"; // ns-3 defaults are left untouched
     /* Command line parameters */
 
     CommandLine cmd;
@@ -105,6 +148,7 @@ int main (int argc, char *argv[])
     cmd.AddValue ("offeredLoad", "Offered Load [Mbps]", offeredLoad);
     cmd.AddValue ("packetSize", "Packet size [s]", packetSize);
     cmd.AddValue ("warmupTime", "Warm-up time [s]", warmupTime);
+    cmd.AddValue ("aggProfile", "Aggregation/TXOP profile: default, legacy, max-aggregation or low-latency", aggProfileName);
     cmd.Parse (argc,argv);
 
     // Print simulation settings to screen
@@ -113,6 +157,7 @@ int main (int argc, char *argv[])
     std::cout << "- number of transmitting stations per AP: " << stations << std::endl;  
     std::cout << "- offered load: " << offeredLoad << " Mb/s" << std::endl;  
     std::cout << "- RTS/CTS enabled: " << enableRtsCts << std::endl;      
+    std::cout << "- aggregation profile: " << aggProfileName << std::endl;
 
 
     int APs =  countAPs(layers);
@@ -232,6 +277,19 @@ int main (int argc, char *argv[])
     }
     Config::Set ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/HeConfiguration/GuardInterval", TimeValue (NanoSeconds (800))); // LONG GI set
 
+    /* Select aggregation profile */
+
+    bool useAggProfile = (aggProfileName != "default");
+    AggProfile aggProfile = {};
+    if (useAggProfile) {
+	aggProfile = getAggProfile(aggProfileName, phy);
+	Config::SetDefault ("ns3::WifiMac::BE_MaxAmpduSize", UintegerValue (aggProfile.maxAmpduSize));
+	Config::SetDefault ("ns3::WifiMac::BE_MaxAmsduSize", UintegerValue (aggProfile.maxAmsduSize));
+	// The Block Ack buffer size attribute moved from HeConfiguration to WifiMac in newer ns-3 releases
+	if (phy == "ax" && !Config::SetDefaultFailSafe ("ns3::WifiMac::MpduBufferSize", UintegerValue (aggProfile.mpduBufferSize)))
+	    Config::SetDefault ("ns3::HeConfiguration::MpduBufferSize", UintegerValue (aggProfile.mpduBufferSize));
+    }
+
     /* Set up Channel */
 
     YansWifiChannelHelper wifiChannel = YansWifiChannelHelper::Default ();
@@ -277,6 +335,16 @@ int main (int argc, char *argv[])
 	staDevices[i].Add(staDevice);
     }
 
+    /* Set TXOP limits (STAs also adopt the AP's value from its EDCA Parameter Set) */
+
+    if (useAggProfile) {
+	for(int i = 0; i < APs; ++i){
+	    setTxopLimit(apDevices.Get(i), aggProfile.txopLimit);
+	    for(int j = 0; j < stations; ++j)
+		setTxopLimit(staDevices[i].Get(j), aggProfile.txopLimit);
+	}
+    }
+
     /* Configure Internet stack */
 
     InternetStackHelper stack;
@@ -329,6 +397,14 @@ int main (int argc, char *argv[])
 
     /* Configure tracing */
 
+    // Per-device counters: devStats[AP][0] is the AP, devStats[AP][1..stations] are its STAs
+    std::vector<std::vector<DeviceStats>> devStats (APs, std::vector<DeviceStats> (stations + 1));
+    for(int i = 0; i < APs; ++i){
+	connectDeviceStats(apDevices.Get(i), &devStats[i][0], Seconds (warmupTime));
+	for(int j = 0; j < stations; ++j)
+	    connectDeviceStats(staDevices[i].Get(j), &devStats[i][j+1], Seconds (warmupTime));
+    }
+
     //EnablePcap ();
 
     if(pcap) {
@@ -359,6 +435,12 @@ int main (int argc, char *argv[])
     std::chrono::duration<double> elapsed = finish - start;
     std::cout << "Elapsed time: " << elapsed.count() << " s\n\n";    
 
+    for(int i = 0; i < APs; ++i){
+	flushDeviceStats(apDevices.Get(i), &devStats[i][0], Seconds (simulationTime));
+	for(int j = 0; j < stations; ++j)
+	    flushDeviceStats(staDevices[i].Get(j), &devStats[i][j+1], Seconds (simulationTime));
+    }
+
     /* Calculate results */
     double flowThr;
     double flowDel;
@@ -374,6 +456,8 @@ int main (int argc, char *argv[])
     }
 
     double totalThr=0;
+    double totalDelaySum=0;
+    uint64_t totalRxPackets=0;
 
     Ptr<Ipv4FlowClassifier> classifier = DynamicCast<Ipv4FlowClassifier> (flowmon.GetClassifier ());
     std::map<FlowId, FlowMonitor::FlowStats> stats = monitor->GetFlowStats ();
@@ -387,12 +471,115 @@ int main (int argc, char *argv[])
 	myfile << std::put_time(&tm, "%Y-%m-%d %H:%M") << "," << offeredLoad << "," << RngSeedManager::GetRun() << "," << t.sourceAddress << "," << t.destinationAddress << "," << flowThr << "," << flowDel;
 	myfile << std::endl;
 	totalThr += flowThr;
+	totalDelaySum += i->second.delaySum.GetSeconds ();
+	totalRxPackets += i->second.rxPackets;
     }
     myfile.close();
 
+    /* Write per-device airtime counters */
+
+    ofstream devfile;
+    if (fileExists(outputDevCsv))
+    {
+	devfile.open (outputDevCsv, ios::app);
+    }
+    else {
+	devfile.open (outputDevCsv, ios::app);
+	devfile << "Timestamp,OfferedLoad,RngRun,AP,Ring,Device,AggProfile,IdleTime,CcaBusyTime,TxTime,RxTime,RxOk,RxError,RxOkOther,RxErrorOther,RxDropBusy,RxDropOther,Retransmissions,DataPpdus,DataMpdus,MaxAmpdu,PayloadTime" << std::endl;
+    }
+
+    int rings = hexRing(APs - 1) + 1;
+    std::vector<DeviceStats> ringApStats (rings);
+    std::vector<DeviceStats> ringStaStats (rings);
+    std::vector<int> ringAPs (rings, 0);
+
+    auto time = std::time(nullptr); //Get timestamp
+    auto tm = *std::localtime(&time);
+    for(int i = 0; i < APs; ++i){
+	int ring = hexRing(i);
+	ringAPs[ring]++;
+	for(int j = 0; j <= stations; ++j){
+	    const DeviceStats &d = devStats[i][j];
+	    devfile << std::put_time(&tm, "%Y-%m-%d %H:%M") << "," << offeredLoad << "," << RngSeedManager::GetRun() << "," << i << "," << ring << ",";
+	    if (j == 0) devfile << "AP"; else devfile << "STA" << j-1;
+	    devfile << "," << aggProfileName << "," << d.idleTime << "," << d.ccaBusyTime << "," << d.txTime << "," << d.rxTime << "," << d.rxOk << "," << d.rxError << "," << d.rxOkOther << "," << d.rxErrorOther << "," << d.rxDropBusy << "," << d.rxDropOther << "," << d.retransmissions << "," << d.dataPpdus << "," << d.dataMpdus << "," << d.maxAmpdu << "," << d.payloadTime;
+	    devfile << std::endl;
+
+	    DeviceStats &r = (j == 0) ? ringApStats[ring] : ringStaStats[ring];
+	    r.idleTime += d.idleTime;
+	    r.ccaBusyTime += d.ccaBusyTime;
+	    r.txTime += d.txTime;
+	    r.rxTime += d.rxTime;
+	    r.rxOk += d.rxOk;
+	    r.rxError += d.rxError;
+	    r.rxOkOther += d.rxOkOther;
+	    r.rxErrorOther += d.rxErrorOther;
+	    r.rxDropBusy += d.rxDropBusy;
+	    r.rxDropOther += d.rxDropOther;
+	    r.retransmissions += d.retransmissions;
+	    r.dataPpdus += d.dataPpdus;
+	    r.dataMpdus += d.dataMpdus;
+	    r.maxAmpdu = std::max(r.maxAmpdu, d.maxAmpdu);
+	    r.payloadTime += d.payloadTime;
+	}
+    }
+    devfile.close();
+
+    // MAC efficiency: airtime spent on first transmissions of MSDU bytes over total airtime
+    // (incl. retransmissions, preambles, headers, A-MSDU subframe headers, control and management frames)
+    DeviceStats total;
+    for(int ring = 0; ring < rings; ++ring){
+	total.txTime += ringApStats[ring].txTime + ringStaStats[ring].txTime;
+	total.payloadTime += ringApStats[ring].payloadTime + ringStaStats[ring].payloadTime;
+	total.dataPpdus += ringApStats[ring].dataPpdus + ringStaStats[ring].dataPpdus;
+	total.dataMpdus += ringApStats[ring].dataMpdus + ringStaStats[ring].dataMpdus;
+    }
+    double macEfficiency = total.txTime > 0 ? total.payloadTime / total.txTime : 0;
+    double mpdusPerPpdu = total.dataPpdus ? (double) total.dataMpdus / total.dataPpdus : 0;
+
+    /* Write per-run summary */
+
+    ofstream runfile;
+    if (fileExists(outputRunCsv))
+    {
+	runfile.open (outputRunCsv, ios::app);
+    }
+    else {
+	runfile.open (outputRunCsv, ios::app);
+	runfile << "Timestamp,OfferedLoad,RngRun,Phy,HighMcs,AggProfile,Throughput,Delay,MacEfficiency,MpdusPerPpdu" << std::endl;
+    }
+    runfile << std::put_time(&tm, "%Y-%m-%d %H:%M") << "," << offeredLoad << "," << RngSeedManager::GetRun() << "," << phy << "," << highMcs << "," << aggProfileName
+	    << "," << totalThr << "," << (totalRxPackets ? totalDelaySum / totalRxPackets : 0) << "," << macEfficiency << "," << mpdusPerPpdu;
+    runfile << std::endl;
+    runfile.close();
+
     //Print results
     std::cout << std::endl << "Results: " << std::endl;
     std::cout << "- aggregate area throughput: " << totalThr << " Mbit/s" << std::endl;
+    std::cout << "- MAC efficiency: " << 100 * macEfficiency << " %" << std::endl;
+    std::cout << "- mean MPDUs per PPDU: " << mpdusPerPpdu << std::endl;
+
+    // Airtime shares are averaged over the devices of each ring and the post-warm-up period
+    double window = simulationTime - warmupTime;
+    for(int ring = 0; ring < rings; ++ring){
+	const DeviceStats &a = ringApStats[ring];
+	const DeviceStats &s = ringStaStats[ring];
+	double apTime = window * ringAPs[ring];
+	double staTime = window * ringAPs[ring] * stations;
+	std::cout << "- ring " << ring << " (" << ringAPs[ring] << " APs):" << std::endl;
+	if (window > 0) {
+	    std::cout << "  AP  airtime [%]: idle " << 100 * a.idleTime / apTime << ", CCA-busy " << 100 * a.ccaBusyTime / apTime
+		      << ", TX " << 100 * a.txTime / apTime << ", RX " << 100 * a.rxTime / apTime << std::endl;
+	    if (stations > 0)
+		std::cout << "  STA airtime [%]: idle " << 100 * s.idleTime / staTime << ", CCA-busy " << 100 * s.ccaBusyTime / staTime
+			  << ", TX " << 100 * s.txTime / staTime << ", RX " << 100 * s.rxTime / staTime << std::endl;
+	}
+	std::cout << "  AP receptions addressed to it: " << a.rxOk << " ok, " << a.rxError << " failed; other (incl. OBSS): "
+		  << a.rxOkOther << " ok, " << a.rxErrorOther << " failed" << std::endl;
+	std::cout << "  AP dropped PPDUs: " << a.rxDropBusy << " while receiving/transmitting, " << a.rxDropOther << " other" << std::endl;
+	std::cout << "  STA retransmitted MPDUs: " << s.retransmissions
+		  << "; mean STA A-MPDU size: " << (s.dataPpdus ? (double) s.dataMpdus / s.dataPpdus : 0) << " MPDUs" << std::endl;
+    }
 
     /* End of simulation */
     Simulator::Destroy ();
@@ -679,6 +866,202 @@ void installTrafficGenerator(Ptr<ns3::Node> fromNode, Ptr<ns3::Node> toNode, int
 
 
 
+}
+
+int hexRing(int APindex) {
+    // Ring r holds 6*r APs, so it ends at AP index 3*r*(r+1)
+    int ring = 0;
+    while (APindex > 3*ring*(ring+1))
+	ring++;
+    return ring;
+}
+
+void addStateTime(DeviceStats *stats, WifiPhyState state, double t) {
+    switch (state)
+    {
+	case WifiPhyState::IDLE:
+	    stats->idleTime += t;
+	    break;
+	case WifiPhyState::CCA_BUSY:
+	    stats->ccaBusyTime += t;
+	    break;
+	case WifiPhyState::TX:
+	    stats->txTime += t;
+	    break;
+	case WifiPhyState::RX:
+	    stats->rxTime += t;
+	    break;
+	default:
+	    break;
+    }
+}
+
+void phyStateTrace(DeviceStats *stats, Time start, Time duration, WifiPhyState state) {
+    Time end = start + duration;
+    stats->lastStateEnd = std::max (stats->lastStateEnd, end);
+    if (end <= stats->start)
+	return;
+    if (start < stats->start)
+	start = stats->start; // Count only the part of the period after the warm-up
+
+    addStateTime(stats, state, (end - start).GetSeconds ());
+}
+
+bool isAddressedTo(Ptr<const Packet> packet, Mac48Address address) {
+    // VHT/HE PSDUs and HT A-MPDUs start with an A-MPDU subframe header
+    Ptr<Packet> copy = packet->Copy ();
+    AmpduSubframeHeader subframeHdr;
+    copy->PeekHeader (subframeHdr);
+    if (subframeHdr.IsSignatureValid ())
+	copy->RemoveHeader (subframeHdr);
+
+    WifiMacHeader hdr;
+    copy->PeekHeader (hdr);
+    return hdr.GetAddr1 () == address;
+}
+
+void phyRxOkTrace(DeviceStats *stats, Ptr<const Packet> packet, double snr, WifiMode mode, WifiPreamble preamble) {
+    if (Simulator::Now () < stats->start)
+	return;
+    if (isAddressedTo(packet, stats->address))
+	stats->rxOk++;
+    else
+	stats->rxOkOther++;
+}
+
+void phyRxErrorTrace(DeviceStats *stats, Ptr<const Packet> packet, double snr) {
+    if (Simulator::Now () < stats->start)
+	return;
+    if (isAddressedTo(packet, stats->address))
+	stats->rxError++;
+    else
+	stats->rxErrorOther++;
+}
+
+void phyRxDropTrace(DeviceStats *stats, Ptr<const Packet> packet, WifiPhyRxfailureReason reason) {
+    if (Simulator::Now () < stats->start)
+	return;
+    if (reason == RXING || reason == TXING)
+	stats->rxDropBusy++;
+    else
+	stats->rxDropOther++;
+}
+
+uint32_t getMsduBytes(const WifiMacHeader &hdr, Ptr<const Packet> payload) {
+    if (!hdr.IsQosAmsdu ())
+	return payload->GetSize ();
+
+    // Leave out A-MSDU subframe headers and the padding between subframes
+    uint32_t msduBytes = 0;
+    Ptr<Packet> amsdu = payload->Copy ();
+    while (amsdu->GetSize () > 0)
+    {
+	AmsduSubframeHeader subframeHdr;
+	amsdu->RemoveHeader (subframeHdr);
+	uint32_t length = subframeHdr.GetLength ();
+	uint32_t padding = (4 - ((subframeHdr.GetSerializedSize () + length) % 4)) % 4;
+	msduBytes += length;
+	amsdu->RemoveAtStart (std::min (length + padding, amsdu->GetSize ()));
+    }
+    return msduBytes;
+}
+
+void phyTxPsduBeginTrace(DeviceStats *stats, WifiConstPsduMap psduMap, WifiTxVector txVector, double txPowerW) {
+    if (Simulator::Now () < stats->start)
+	return;
+
+    for (auto &it : psduMap)
+    {
+	Ptr<const WifiPsdu> psdu = it.second;
+	if (!psdu->GetHeader (0).IsQosData ())
+	    continue;
+	uint32_t nMpdus = psdu->GetNMpdus ();
+	uint32_t payloadBytes = 0;
+	for (uint32_t i = 0; i < nMpdus; ++i)
+	{
+	    if (psdu->GetHeader (i).IsRetry ())
+		stats->retransmissions++;
+	    else
+		payloadBytes += getMsduBytes(psdu->GetHeader (i), psdu->GetPayload (i));
+	}
+	stats->payloadTime += payloadBytes * 8.0 / txVector.GetMode ().GetDataRate (txVector);
+	stats->dataPpdus++;
+	stats->dataMpdus += nMpdus;
+	stats->maxAmpdu = std::max (stats->maxAmpdu, nMpdus);
+    }
+}
+
+void connectDeviceStats(Ptr<NetDevice> device, DeviceStats *stats, Time start) {
+    Ptr<WifiNetDevice> wifiDevice = DynamicCast<WifiNetDevice> (device);
+    Ptr<WifiPhy> phy = wifiDevice->GetPhy ();
+
+    stats->address = wifiDevice->GetMac ()->GetAddress ();
+    stats->start = start;
+    stats->lastStateEnd = start;
+
+    phy->GetState ()->TraceConnectWithoutContext ("State", MakeBoundCallback (&phyStateTrace, stats));
+    phy->GetState ()->TraceConnectWithoutContext ("RxOk", MakeBoundCallback (&phyRxOkTrace, stats));
+    phy->GetState ()->TraceConnectWithoutContext ("RxError", MakeBoundCallback (&phyRxErrorTrace, stats));
+    phy->TraceConnectWithoutContext ("PhyRxDrop", MakeBoundCallback (&phyRxDropTrace, stats));
+    phy->TraceConnectWithoutContext ("PhyTxPsduBegin", MakeBoundCallback (&phyTxPsduBeginTrace, stats));
+}
+
+void flushDeviceStats(Ptr<NetDevice> device, DeviceStats *stats, Time end) {
+    if (end <= stats->start)
+	return;
+
+    // The State trace reports a period when it ends (TX when it starts), and finished CCA_BUSY/IDLE
+    // periods only at the next state change. Force that change with a zero-length channel switch;
+    // the simulation is over, so its side effects on the MAC do not matter.
+    Ptr<WifiPhy> phy = DynamicCast<WifiNetDevice> (device)->GetPhy ();
+    Ptr<WifiPhyStateHelper> state = phy->GetState ();
+    if (state->IsStateIdle () || state->IsStateCcaBusy () || state->IsStateRx ())
+	state->SwitchToChannelSwitching (Seconds (0));
+
+    if (stats->lastStateEnd < end)
+	addStateTime(stats, state->GetState (), (end - stats->lastStateEnd).GetSeconds ());
+    else if (stats->lastStateEnd > end)
+	stats->txTime -= (stats->lastStateEnd - end).GetSeconds (); // Ongoing TX was logged up to its end
+    stats->lastStateEnd = end;
+}
+
+AggProfile getAggProfile(std::string name, std::string phy) {
+    // Largest A-MPDU and A-MSDU each PHY allows
+    uint32_t maxAmpdu = 65535;
+    uint16_t maxAmsdu = 7935;
+    if (phy == "ac") {
+	maxAmpdu = 1048575;
+	maxAmsdu = 11398;
+    }
+    else if (phy == "ax") {
+	maxAmpdu = 6500631;
+	maxAmsdu = 11398;
+    }
+
+    AggProfile profile;
+    if (name == "legacy") {
+	// One MPDU per PPDU, as in pre-802.11n networks
+	profile = {0, 0, 64, Seconds (0)};
+    }
+    else if (name == "max-aggregation") {
+	// Largest A-MPDUs of A-MSDUs, limited only by the maximum PPDU duration
+	profile = {maxAmpdu, maxAmsdu, 256, Seconds (0)};
+    }
+    else if (name == "low-latency") {
+	// A-MPDUs without A-MSDUs, bounded by a short TXOP so that channel access is shared more often
+	profile = {maxAmpdu, 0, 64, MicroSeconds (1024)};
+    }
+    else {
+	std::cout<<"Given aggregation profile doesn't exist. Choose one of the following:\n1. default\n2. legacy\n3. max-aggregation\n4. low-latency"<<endl;
+	exit(0);
+    }
+
+    return profile;
+}
+
+void setTxopLimit(Ptr<NetDevice> device, Time txopLimit) {
+    Ptr<WifiNetDevice> wifiDevice = DynamicCast<WifiNetDevice> (device);
+    wifiDevice->GetMac ()->GetQosTxop (AC_BE)->SetTxopLimit (txopLimit);
 }
 
 /***** End of functions definition *****/